@@ -1,4 +1,4 @@
-QT       += core gui printsupport
+QT       += core gui printsupport concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -10,14 +10,49 @@ CONFIG += c++17
 
 SOURCES += \
     aboutwindow.cpp \
+    compressedio.cpp \
     contactswindow.cpp \
+    filereloader.cpp \
+    folderindex.cpp \
+    imageprovider.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    memoryreport.cpp \
+    memorywindow.cpp \
+    searchwindow.cpp \
+    spellchecker.cpp \
+    spelldictionary.cpp \
+    texteditor.cpp
 
 HEADERS += \
     aboutwindow.h \
+    compressedio.h \
     contactswindow.h \
-    mainwindow.h
+    filereloader.h \
+    folderindex.h \
+    imageprovider.h \
+    mainwindow.h \
+    memoryreport.h \
+    memorywindow.h \
+    searchwindow.h \
+    spellchecker.h \
+    spelldictionary.h \
+    texteditor.h
+
+win32: LIBS += -lpsapi
+
+# Compressed documents (*.gz, *.zst), each codec is enabled when its library is found
+unix {
+    CONFIG += link_pkgconfig
+    packagesExist(zlib) {
+        PKGCONFIG += zlib
+        DEFINES += TEXEDIT_HAVE_ZLIB
+    }
+    packagesExist(libzstd) {
+        PKGCONFIG += libzstd
+        DEFINES += TEXEDIT_HAVE_ZSTD
+    }
+}
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "compressedio.h"
+
+#include <QtConcurrent>
+#include <QFile>
+#include <QSaveFile>
+#include <QStringView>
+
+#ifdef TEXEDIT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef TEXEDIT_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <memory>
+
+static const qsizetype kBufferSize = 64 * 1024;
+static const qsizetype kTextChunk = 256 * 1024;
+
+// Makes room for at least `size` more bytes at the end of `out` and returns
+// a pointer to it; capacity grows geometrically to keep appends cheap.
+static char *appendSpace(QByteArray *out, qsizetype size) {
+    qsizetype used = out->size();
+    if (out->capacity() < used + size) {
+        out->reserve(qMax(out->capacity() * 2, used + size));
+    }
+    out->resize(used + size);
+    return out->data() + used;
+}
+
+#ifdef TEXEDIT_HAVE_ZLIB
+static bool inflateGzip(QFile &file, QByteArray *out) {
+    z_stream stream = {};
+    if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+        return false;
+    }
+
+    QByteArray input(kBufferSize, Qt::Uninitialized);
+    int status = Z_OK;
+    bool ok = true;
+
+    while (ok) {
+        qint64 read = file.read(input.data(), input.size());
+        if (read <= 0) {
+            ok = read == 0 && status == Z_STREAM_END;
+            break;
+        }
+
+        stream.next_in = reinterpret_cast<Bytef *>(input.data());
+        stream.avail_in = uInt(read);
+
+        while (true) {
+            stream.next_out = reinterpret_cast<Bytef *>(appendSpace(out, kBufferSize));
+            stream.avail_out = uInt(kBufferSize);
+            status = inflate(&stream, Z_NO_FLUSH);
+            out->chop(stream.avail_out);
+
+            if (status == Z_STREAM_END) {
+                if (stream.avail_in == 0) {
+                    break;
+                }
+                // Concatenated gzip members.
+                inflateReset(&stream);
+                continue;
+            }
+            if (status != Z_OK && status != Z_BUF_ERROR) {
+                ok = false;
+                break;
+            }
+            if (stream.avail_out != 0) {
+                break;
+            }
+        }
+    }
+
+    inflateEnd(&stream);
+    return ok;
+}
+#endif
+
+#ifdef TEXEDIT_HAVE_ZSTD
+static bool decompressZstd(QFile &file, QByteArray *out) {
+    ZSTD_DCtx *context = ZSTD_createDCtx();
+    if (!context) {
+        return false;
+    }
+
+    QByteArray input(kBufferSize, Qt::Uninitialized);
+    size_t status = 0;
+    bool ok = true;
+
+    while (ok) {
+        qint64 read = file.read(input.data(), input.size());
+        if (read <= 0) {
+            // A non-zero status means the last frame is incomplete.
+            ok = read == 0 && status == 0;
+            break;
+        }
+
+        ZSTD_inBuffer in = { input.constData(), size_t(read), 0 };
+        while (in.pos < in.size) {
+            ZSTD_outBuffer outBuffer = { appendSpace(out, kBufferSize), size_t(kBufferSize), 0 };
+            status = ZSTD_decompressStream(context, &outBuffer, &in);
+            out->chop(kBufferSize - qsizetype(outBuffer.pos));
+            if (ZSTD_isError(status)) {
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    ZSTD_freeDCtx(context);
+    return ok;
+}
+#endif
+
+// Sink for encoded text, compressing it on the way to the file if needed.
+class Encoder
+{
+public:
+    explicit Encoder(QIODevice &_file) : file(_file) {}
+    virtual ~Encoder() {}
+
+    virtual bool write(const char *data, qsizetype size) {
+        return file.write(data, size) == size;
+    }
+    virtual bool finish() {
+        return true;
+    }
+
+protected:
+    QIODevice &file;
+};
+
+#ifdef TEXEDIT_HAVE_ZLIB
+class GzipEncoder : public Encoder
+{
+public:
+    explicit GzipEncoder(QIODevice &file) : Encoder(file), buffer(kBufferSize, Qt::Uninitialized) {
+        ready = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+    ~GzipEncoder() {
+        if (ready) {
+            deflateEnd(&stream);
+        }
+    }
+
+    bool write(const char *data, qsizetype size) override {
+        return pump(data, size, Z_NO_FLUSH);
+    }
+    bool finish() override {
+        return pump(nullptr, 0, Z_FINISH);
+    }
+
+private:
+    bool pump(const char *data, qsizetype size, int flush) {
+        if (!ready) {
+            return false;
+        }
+
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        stream.avail_in = uInt(size);
+
+        int status;
+        do {
+            stream.next_out = reinterpret_cast<Bytef *>(buffer.data());
+            stream.avail_out = uInt(buffer.size());
+            status = deflate(&stream, flush);
+            if (status == Z_STREAM_ERROR) {
+                return false;
+            }
+            qsizetype produced = buffer.size() - stream.avail_out;
+            if (file.write(buffer.constData(), produced) != produced) {
+                return false;
+            }
+        } while (stream.avail_out == 0 || (flush == Z_FINISH && status != Z_STREAM_END));
+
+        return true;
+    }
+
+    z_stream stream = {};
+    QByteArray buffer;
+    bool ready;
+};
+#endif
+
+#ifdef TEXEDIT_HAVE_ZSTD
+class ZstdEncoder : public Encoder
+{
+public:
+    explicit ZstdEncoder(QIODevice &file)
+        : Encoder(file), context(ZSTD_createCCtx()), buffer(qsizetype(ZSTD_CStreamOutSize()), Qt::Uninitialized) {}
+    ~ZstdEncoder() {
+        ZSTD_freeCCtx(context);
+    }
+
+    bool write(const char *data, qsizetype size) override {
+        return pump(data, size, ZSTD_e_continue);
+    }
+    bool finish() override {
+        return pump(nullptr, 0, ZSTD_e_end);
+    }
+
+private:
+    bool pump(const char *data, qsizetype size, ZSTD_EndDirective mode) {
+        if (!context) {
+            return false;
+        }
+
+        ZSTD_inBuffer in = { data, size_t(size), 0 };
+        size_t remaining;
+        do {
+            ZSTD_outBuffer out = { buffer.data(), size_t(buffer.size()), 0 };
+            remaining = ZSTD_compressStream2(context, &out, &in, mode);
+            if (ZSTD_isError(remaining)) {
+                return false;
+            }
+            if (file.write(buffer.constData(), qint64(out.pos)) != qint64(out.pos)) {
+                return false;
+            }
+        } while (mode == ZSTD_e_end ? remaining != 0 : in.pos != in.size);
+
+        return true;
+    }
+
+    ZSTD_CCtx *context;
+    QByteArray buffer;
+};
+#endif
+
+CompressedIO::Codec CompressedIO::codecFor(const QString &path) {
+    if (path.endsWith(".gz", Qt::CaseInsensitive)) {
+        return Codec::Gzip;
+    }
+    if (path.endsWith(".zst", Qt::CaseInsensitive)) {
+        return Codec::Zstd;
+    }
+    return Codec::None;
+}
+
+CompressedIO::Result CompressedIO::readText(const QString &path) {
+    Result result;
+    Codec codec = codecFor(path);
+
+    QFile file(path);
+    QIODevice::OpenMode mode = QIODevice::ReadOnly;
+    if (codec == Codec::None) {
+        mode |= QIODevice::Text;
+    }
+    if (!file.open(mode)) {
+        result.error = "Could not open file: " + file.errorString();
+        return result;
+    }
+
+    QByteArray data;
+    bool ok = true;
+    switch (codec) {
+    case Codec::None:
+        data = file.readAll();
+        break;
+    case Codec::Gzip:
+#ifdef TEXEDIT_HAVE_ZLIB
+        ok = inflateGzip(file, &data);
+#else
+        result.error = "gzip support is not available in this build";
+        return result;
+#endif
+        break;
+    case Codec::Zstd:
+#ifdef TEXEDIT_HAVE_ZSTD
+        ok = decompressZstd(file, &data);
+#else
+        result.error = "zstd support is not available in this build";
+        return result;
+#endif
+        break;
+    }
+    file.close();
+
+    if (!ok) {
+        result.error = "The compressed file is damaged or truncated";
+        return result;
+    }
+
+    result.text = QString::fromUtf8(data);
+    return result;
+}
+
+QString CompressedIO::writeText(const QString &path, const QString &text) {
+    Codec codec = codecFor(path);
+
+    // Written next to the target and renamed over it on success, so a failed
+    // or interrupted save never leaves a truncated document behind.
+    QSaveFile file(path);
+    QIODevice::OpenMode mode = QIODevice::WriteOnly;
+    if (codec == Codec::None) {
+        mode |= QIODevice::Text;
+    }
+    if (!file.open(mode)) {
+        return "Could not save file: " + file.errorString();
+    }
+
+    std::unique_ptr<Encoder> encoder;
+    switch (codec) {
+    case Codec::None:
+        encoder.reset(new Encoder(file));
+        break;
+    case Codec::Gzip:
+#ifdef TEXEDIT_HAVE_ZLIB
+        encoder.reset(new GzipEncoder(file));
+#else
+        return "gzip support is not available in this build";
+#endif
+        break;
+    case Codec::Zstd:
+#ifdef TEXEDIT_HAVE_ZSTD
+        encoder.reset(new ZstdEncoder(file));
+#else
+        return "zstd support is not available in this build";
+#endif
+        break;
+    }
+
+    // Encode the text piecewise instead of converting it to UTF-8 at once.
+    qsizetype pos = 0;
+    while (pos < text.size()) {
+        qsizetype length = qMin(kTextChunk, text.size() - pos);
+        if (pos + length < text.size() && text.at(pos + length - 1).isHighSurrogate()) {
+            --length;
+        }
+        QByteArray chunk = QStringView(text).mid(pos, length).toUtf8();
+        if (!encoder->write(chunk.constData(), chunk.size())) {
+            return "Could not save file: write failed";
+        }
+        pos += length;
+    }
+    if (!encoder->finish()) {
+        return "Could not save file: write failed";
+    }
+
+    encoder.reset();
+    if (!file.commit()) {
+        return "Could not save file: " + file.errorString();
+    }
+    return QString();
+}
+
+QFuture<CompressedIO::Result> CompressedIO::readTextAsync(const QString &path) {
+    return QtConcurrent::run([path]() {
+        return readText(path);
+    });
+}
+
+QFuture<QString> CompressedIO::writeTextAsync(const QString &path, const QString &text) {
+    return QtConcurrent::run([path, text]() {
+        return writeText(path, text);
+    });
+}
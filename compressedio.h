@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef COMPRESSEDIO_H
+#define COMPRESSEDIO_H
+
+#include <QString>
+#include <QFuture>
+
+// Reading and writing of text documents that may be compressed, picked by
+// the file suffix: "*.gz" is gzip, "*.zst" is zstd, anything else is plain.
+// Data goes through the codec in fixed-size buffers, so the compressed copy
+// of a document is never held in memory.
+namespace CompressedIO
+{
+    enum class Codec { None, Gzip, Zstd };
+
+    struct Result
+    {
+        QString text;
+        QString error;
+
+        bool ok() const { return error.isEmpty(); }
+    };
+
+    Codec codecFor(const QString &path);
+
+    // Blocking versions, safe to call from any thread.
+    Result readText(const QString &path);
+    QString writeText(const QString &path, const QString &text);
+
+    // Run the blocking versions on the global thread pool.
+    QFuture<Result> readTextAsync(const QString &path);
+    QFuture<QString> writeTextAsync(const QString &path, const QString &text);
+}
+
+#endif // COMPRESSEDIO_H
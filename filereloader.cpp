@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "filereloader.h"
+#include "compressedio.h"
+
+#include <QtConcurrent>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QMessageBox>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocumentFragment>
+#include <QTextFrame>
+
+FileReloader::FileReloader(QTextEdit *_textEdit, QWidget *parent)
+    : QObject(parent), textEdit(_textEdit)
+{
+    watcher = new QFileSystemWatcher(this);
+    job = new QFutureWatcher<ReloadResult>(this);
+
+    // Pipelines usually write a file in several chunks, wait until it settles.
+    debounce = new QTimer(this);
+    debounce->setSingleShot(true);
+    debounce->setInterval(300);
+
+    connect(watcher, &QFileSystemWatcher::fileChanged, debounce, qOverload<>(&QTimer::start));
+    connect(debounce, &QTimer::timeout, this, &FileReloader::checkFile);
+    connect(job, &QFutureWatcher<ReloadResult>::finished, this, &FileReloader::finished);
+}
+
+FileReloader::~FileReloader() {
+    job->waitForFinished();
+}
+
+void FileReloader::watch(const QString &path, int revision) {
+    if (!watcher->files().isEmpty()) {
+        watcher->removePaths(watcher->files());
+    }
+
+    ++generation;
+    filePath = path;
+    baseline.clear();
+    baselineRevision = revision < 0 ? textEdit->document()->revision() : revision;
+    pending = false;
+
+    if (filePath.isEmpty() || filePath == "none" || !QFileInfo::exists(filePath)) {
+        filePath.clear();
+        return;
+    }
+
+    QFileInfo info(filePath);
+    knownModified = info.lastModified();
+    knownSize = info.size();
+    watcher->addPath(filePath);
+
+    // The document was just loaded from (or saved to) this file, so hashing
+    // a fresh parse of it gives the baseline without blocking the UI.
+    start(QList<size_t>(), false, baselineRevision);
+}
+
+qint64 FileReloader::cacheBytes() const {
+    return baseline.size() * qint64(sizeof(size_t));
+}
+
+void FileReloader::checkFile() {
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    QFileInfo info(filePath);
+    if (!info.exists()) {
+        // Replaced by rename, the new file shows up with the next notification.
+        return;
+    }
+    if (!watcher->files().contains(filePath)) {
+        watcher->addPath(filePath);
+    }
+    if (info.lastModified() == knownModified && info.size() == knownSize) {
+        return;
+    }
+    if (job->isRunning()) {
+        pending = true;
+        return;
+    }
+
+    knownModified = info.lastModified();
+    knownSize = info.size();
+
+    QTextDocument *document = textEdit->document();
+    QList<size_t> hashes = baseline;
+    if (document->revision() != baselineRevision) {
+        QMessageBox::StandardButton reply;
+        reply = QMessageBox::question(textEdit, "File changed",
+                                      "The file has been changed by another program. Reload it and lose your changes?",
+                                      QMessageBox::Yes | QMessageBox::No);
+        if (reply == QMessageBox::No) {
+            return;
+        }
+        hashes.clear();
+    }
+    // An empty list asks for a full reload, see diffFile().
+    if (!document->rootFrame()->childFrames().isEmpty()) {
+        hashes.clear();
+    } else if (hashes.isEmpty()) {
+        hashes = documentHashes(document);
+    }
+
+    start(hashes, true, document->revision());
+}
+
+void FileReloader::start(const QList<size_t> &hashes, bool reload, int revision) {
+    const QString path = filePath;
+    const int jobGeneration = generation;
+
+    job->setFuture(QtConcurrent::run([=]() {
+        ReloadResult result = diffFile(path, hashes, reload);
+        result.generation = jobGeneration;
+        result.revision = revision;
+        return result;
+    }));
+}
+
+void FileReloader::finished() {
+    ReloadResult result = job->result();
+
+    if (result.generation == generation && result.ok) {
+        if (result.reload && textEdit->document()->revision() != result.revision) {
+            // Edited while the diff was being computed, start over.
+            knownModified = QDateTime();
+            pending = true;
+        } else if (result.reload) {
+            apply(result);
+            baseline = result.hashes;
+            baselineRevision = textEdit->document()->revision();
+        } else {
+            // Edits made while the file was written or parsed are not in it.
+            baseline = result.hashes;
+            baselineRevision = result.revision;
+        }
+    }
+
+    if (pending) {
+        pending = false;
+        checkFile();
+    }
+}
+
+void FileReloader::apply(const ReloadResult &result) {
+    QTextDocument *document = textEdit->document();
+    int vScroll = textEdit->verticalScrollBar()->value();
+    int hScroll = textEdit->horizontalScrollBar()->value();
+
+    if (result.full) {
+        QTextCursor cursor = textEdit->textCursor();
+        int anchor = cursor.anchor();
+        int position = cursor.position();
+
+        textEdit->setHtml(result.html);
+
+        int last = document->characterCount() - 1;
+        cursor = QTextCursor(document);
+        cursor.setPosition(qMin(anchor, last));
+        cursor.setPosition(qMin(position, last), QTextCursor::KeepAnchor);
+        textEdit->setTextCursor(cursor);
+    } else if (result.first < result.oldEnd) {
+        QTextBlock firstBlock = document->findBlockByNumber(result.first);
+        QTextBlock lastBlock = document->findBlockByNumber(result.oldEnd - 1);
+
+        // The editor's own cursor is moved by the document, a separate
+        // cursor keeps it and the selection where the user left them.
+        QTextCursor cursor(document);
+        cursor.beginEditBlock();
+        cursor.setPosition(firstBlock.position());
+        cursor.setPosition(lastBlock.position() + lastBlock.length() - 1, QTextCursor::KeepAnchor);
+        cursor.removeSelectedText();
+        QTextDocumentFragment fragment = QTextDocumentFragment::fromHtml(result.html, document);
+        if (!fragment.isEmpty()) {
+            cursor.insertFragment(fragment);
+        }
+        cursor.endEditBlock();
+    }
+
+    textEdit->verticalScrollBar()->setValue(vScroll);
+    textEdit->horizontalScrollBar()->setValue(hScroll);
+    emit reloaded();
+}
+
+static size_t blockHash(const QTextBlock &block) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << block.text() << block.blockFormat();
+    for (QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it) {
+        stream << it.fragment().length() << it.fragment().charFormat();
+    }
+    return qHash(data);
+}
+
+QList<size_t> FileReloader::documentHashes(QTextDocument *document) {
+    QList<size_t> hashes;
+    hashes.reserve(document->blockCount());
+    for (QTextBlock block = document->begin(); block.isValid(); block = block.next()) {
+        hashes.append(blockHash(block));
+    }
+    return hashes;
+}
+
+ReloadResult FileReloader::diffFile(const QString &path, const QList<size_t> &oldHashes, bool reload) {
+    ReloadResult result;
+    result.reload = reload;
+
+    CompressedIO::Result file = CompressedIO::readText(path);
+    if (!file.ok()) {
+        return result;
+    }
+    QString text = file.text;
+    file.text.clear();
+
+    QTextDocument document;
+    document.setUndoRedoEnabled(false);
+    document.setHtml(text);
+    result.hashes = documentHashes(&document);
+    result.ok = true;
+
+    if (!reload) {
+        return result;
+    }
+
+    // Replacing block ranges inside tables could break the table structure,
+    // documents with frames are reloaded as a whole.
+    if (oldHashes.isEmpty() || !document.rootFrame()->childFrames().isEmpty()) {
+        result.full = true;
+        result.html = text;
+        return result;
+    }
+
+    const QList<size_t> &newHashes = result.hashes;
+    int oldCount = oldHashes.size();
+    int newCount = newHashes.size();
+
+    int prefix = 0;
+    while (prefix < oldCount && prefix < newCount && oldHashes[prefix] == newHashes[prefix]) {
+        ++prefix;
+    }
+    int suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix
+           && oldHashes[oldCount - 1 - suffix] == newHashes[newCount - 1 - suffix]) {
+        ++suffix;
+    }
+
+    if (prefix + suffix == oldCount && prefix + suffix == newCount) {
+        return result;
+    }
+
+    // Blocks were only inserted or only removed, widen the range by one
+    // unchanged block so both sides have something to replace.
+    if (prefix + suffix == oldCount || prefix + suffix == newCount) {
+        if (prefix > 0) {
+            --prefix;
+        } else {
+            --suffix;
+        }
+    }
+
+    result.first = prefix;
+    result.oldEnd = oldCount - suffix;
+
+    QTextBlock firstBlock = document.findBlockByNumber(prefix);
+    QTextBlock lastBlock = document.findBlockByNumber(newCount - suffix - 1);
+    QTextCursor cursor(&document);
+    cursor.setPosition(firstBlock.position());
+    cursor.setPosition(lastBlock.position() + lastBlock.length() - 1, QTextCursor::KeepAnchor);
+    result.html = QTextDocumentFragment(cursor).toHtml();
+
+    return result;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef FILERELOADER_H
+#define FILERELOADER_H
+
+#include <QObject>
+#include <QTextEdit>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QDateTime>
+#include <QTimer>
+
+// Result of re-reading a watched file on a worker thread. Blocks
+// [first, oldEnd) of the current document have to be replaced with `html`;
+// when `full` is set `html` holds the whole file instead.
+struct ReloadResult
+{
+    bool ok = false;
+    bool reload = false;
+    bool full = false;
+    int generation = 0;
+    int revision = -1;
+    QList<size_t> hashes;
+    int first = 0;
+    int oldEnd = 0;
+    QString html;
+};
+
+// Watches the file shown in a QTextEdit and, when it is changed by someone
+// else, applies only the blocks that differ, keeping undo history, cursor
+// and scroll position.
+class FileReloader : public QObject
+{
+    Q_OBJECT
+public:
+    FileReloader(QTextEdit *textEdit, QWidget *parent);
+    ~FileReloader();
+
+    // Starts watching `path`, which must match the document as it was at
+    // `revision` (the current one by default). An empty path stops watching.
+    void watch(const QString &path, int revision = -1);
+
+    qint64 cacheBytes() const;
+
+signals:
+    void reloaded();
+
+private:
+    void checkFile();
+    void start(const QList<size_t> &hashes, bool reload, int revision);
+    void finished();
+    void apply(const ReloadResult &result);
+
+    static QList<size_t> documentHashes(QTextDocument *document);
+    static ReloadResult diffFile(const QString &path, const QList<size_t> &oldHashes, bool reload);
+
+    QTextEdit* textEdit;
+    QFileSystemWatcher* watcher;
+    QFutureWatcher<ReloadResult>* job;
+    QTimer* debounce;
+
+    QString filePath;
+    QDateTime knownModified;
+    qint64 knownSize = -1;
+    QList<size_t> baseline;
+    int baselineRevision = -1;
+    int generation = 0;
+    bool pending = false;
+};
+
+#endif // FILERELOADER_H
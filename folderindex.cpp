@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "folderindex.h"
+#include "compressedio.h"
+
+#include <QtConcurrent>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QTextDocument>
+
+#include <algorithm>
+#include <limits>
+
+static const quint32 kIndexMagic = 0x54584958;
+static const quint32 kIndexVersion = 2;
+static const int kBatchSize = 256;
+
+struct Token
+{
+    QString word;
+    int offset;
+    int length;
+};
+
+// Splits text into words: runs of letters and digits, case folded.
+static QList<Token> tokenize(const QString &text) {
+    QList<Token> tokens;
+    const qsizetype size = text.size();
+    qsizetype pos = 0;
+    while (pos < size) {
+        while (pos < size && !text.at(pos).isLetterOrNumber()) {
+            ++pos;
+        }
+        qsizetype start = pos;
+        while (pos < size && text.at(pos).isLetterOrNumber()) {
+            ++pos;
+        }
+        if (pos > start) {
+            tokens.append({ text.mid(start, pos - start).toCaseFolded(), int(start), int(pos - start) });
+        }
+    }
+    return tokens;
+}
+
+struct IndexedFile
+{
+    QString path;
+    qint64 modified = 0;
+    qint64 size = 0;
+    bool ok = false;
+    QHash<QString, QList<QPair<quint32, quint32>>> words;
+};
+
+// Runs on the worker threads. The text is extracted exactly like
+// "Export as text" does it, so offsets are positions in the opened document.
+static IndexedFile indexFile(const QString &root, const QString &path) {
+    IndexedFile result;
+    result.path = path;
+
+    QFileInfo info(QDir(root).filePath(path));
+    result.modified = info.lastModified().toMSecsSinceEpoch();
+    result.size = info.size();
+
+    CompressedIO::Result file = CompressedIO::readText(info.filePath());
+    if (!file.ok()) {
+        return result;
+    }
+
+    QTextDocument document;
+    document.setUndoRedoEnabled(false);
+    document.setHtml(file.text);
+    file.text.clear();
+
+    const QList<Token> tokens = tokenize(document.toPlainText());
+    for (int i = 0; i < tokens.size(); ++i) {
+        result.words[tokens[i].word].append(qMakePair(quint32(i), quint32(tokens[i].offset)));
+    }
+    result.ok = true;
+    return result;
+}
+
+FolderIndex::FolderIndex(const QString &folder)
+    : root(QDir(folder).absolutePath())
+{
+}
+
+int FolderIndex::fileCount() const {
+    return files.size();
+}
+
+static QMutex sharedMutex;
+static QHash<QString, std::weak_ptr<const FolderIndex>> sharedIndexes;
+
+std::shared_ptr<const FolderIndex> FolderIndex::shared(const QString &folder) {
+    QMutexLocker locker(&sharedMutex);
+    return sharedIndexes.value(QDir(folder).absolutePath()).lock();
+}
+
+void FolderIndex::setShared(const std::shared_ptr<const FolderIndex> &index) {
+    QMutexLocker locker(&sharedMutex);
+    sharedIndexes.insert(index->folder(), index);
+}
+
+QString FolderIndex::indexPath() const {
+    QByteArray key = QCryptographicHash::hash(root.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/index/" + key + ".idx";
+}
+
+bool FolderIndex::load() {
+    QFile file(indexPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic, version;
+    QString folder;
+    in >> magic >> version >> folder;
+    if (magic != kIndexMagic || version != kIndexVersion || folder != root) {
+        return false;
+    }
+
+    quint32 fileCount;
+    in >> fileCount;
+    if (in.status() != QDataStream::Ok || fileCount > file.size()) {
+        return false;
+    }
+    QList<FileEntry> loadedFiles(fileCount);
+    for (FileEntry &entry : loadedFiles) {
+        in >> entry.path >> entry.modified >> entry.size;
+    }
+
+    quint32 wordCount;
+    in >> wordCount;
+    QHash<QString, QList<Occurrence>> loadedWords;
+    loadedWords.reserve(wordCount);
+    for (quint32 i = 0; i < wordCount && in.status() == QDataStream::Ok; ++i) {
+        QString word;
+        quint32 count;
+        in >> word >> count;
+        if (count > file.size()) {
+            return false;
+        }
+        QList<Occurrence> &occurrences = loadedWords[word];
+        occurrences.resize(count);
+        for (quint32 j = 0; j < count; ++j) {
+            Occurrence &occurrence = occurrences[j];
+            in >> occurrence.file >> occurrence.ordinal >> occurrence.offset;
+            // search() relies on both, a damaged cache is rebuilt instead.
+            if (occurrence.file >= fileCount || (j > 0 && occurrence < occurrences[j - 1])) {
+                return false;
+            }
+        }
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    files = loadedFiles;
+    words = loadedWords;
+    return true;
+}
+
+bool FolderIndex::save() const {
+    QString path = indexPath();
+    QDir().mkpath(QFileInfo(path).path());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kIndexMagic << kIndexVersion << root;
+
+    out << quint32(files.size());
+    for (const FileEntry &entry : files) {
+        out << entry.path << entry.modified << entry.size;
+    }
+
+    out << quint32(words.size());
+    for (auto it = words.cbegin(); it != words.cend(); ++it) {
+        out << it.key() << quint32(it->size());
+        for (const Occurrence &occurrence : *it) {
+            out << occurrence.file << occurrence.ordinal << occurrence.offset;
+        }
+    }
+
+    return file.commit();
+}
+
+int FolderIndex::update(const std::function<void(int, int)> &progress) {
+    QHash<QString, quint32> ids;
+    for (int i = 0; i < files.size(); ++i) {
+        if (!files[i].path.isEmpty()) {
+            ids.insert(files[i].path, quint32(i));
+        }
+    }
+
+    // Find new and changed files, whatever is left in `ids` was removed.
+    QDir dir(root);
+    QStringList changed;
+    QHash<QString, quint32> changedIds;
+    QSet<quint32> stale;
+    QDirIterator it(root, { "*.html", "*.htm", "*.html.gz", "*.html.zst" }, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QFileInfo info = it.nextFileInfo();
+        QString path = dir.relativeFilePath(info.filePath());
+
+        auto known = ids.find(path);
+        if (known != ids.end()) {
+            const FileEntry &entry = files[*known];
+            if (entry.modified != info.lastModified().toMSecsSinceEpoch() || entry.size != info.size()) {
+                changedIds.insert(path, *known);
+                stale.insert(*known);
+                changed.append(path);
+            }
+            ids.erase(known);
+            continue;
+        }
+        changed.append(path);
+    }
+
+    const int removed = ids.size();
+    for (quint32 id : std::as_const(ids)) {
+        stale.insert(id);
+        files[id].path.clear();
+    }
+
+    // Removed files give up their ids and the rest move down, so ids stay
+    // dense. The mapping keeps their order, postings stay sorted.
+    QList<quint32> remap;
+    if (removed > 0) {
+        remap.resize(files.size());
+        QList<FileEntry> kept;
+        kept.reserve(files.size() - removed);
+        for (int i = 0; i < files.size(); ++i) {
+            remap[i] = quint32(kept.size());
+            if (!files[i].path.isEmpty()) {
+                kept.append(files[i]);
+            }
+        }
+        files = kept;
+        for (quint32 &id : changedIds) {
+            id = remap[id];
+        }
+    }
+
+    if (!stale.isEmpty()) {
+        for (auto word = words.begin(); word != words.end();) {
+            word->removeIf([&stale](const Occurrence &occurrence) {
+                return stale.contains(occurrence.file);
+            });
+            if (!remap.isEmpty()) {
+                for (Occurrence &occurrence : *word) {
+                    occurrence.file = remap[occurrence.file];
+                }
+            }
+            word = word->isEmpty() ? words.erase(word) : std::next(word);
+        }
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+
+    // Reused ids of changed files land at the end of a list, so every list
+    // that got new postings is sorted again afterwards.
+    QSet<QString> touched;
+
+    for (int done = 0; done < changed.size(); done += kBatchSize) {
+        if (progress) {
+            progress(done, changed.size());
+        }
+
+        const QStringList batch = changed.mid(done, kBatchSize);
+        const QList<IndexedFile> indexed = QtConcurrent::blockingMapped<QList<IndexedFile>>(&pool, batch, [this](const QString &path) {
+            return indexFile(root, path);
+        });
+
+        for (const IndexedFile &result : indexed) {
+            quint32 id;
+            auto known = changedIds.constFind(result.path);
+            if (known != changedIds.cend()) {
+                id = *known;
+            } else {
+                id = quint32(files.size());
+                files.append(FileEntry());
+            }
+            files[id].path = result.path;
+            files[id].modified = result.ok ? result.modified : 0;
+            files[id].size = result.size;
+
+            for (auto word = result.words.cbegin(); word != result.words.cend(); ++word) {
+                touched.insert(word.key());
+                QList<Occurrence> &occurrences = words[word.key()];
+                for (const QPair<quint32, quint32> &position : *word) {
+                    occurrences.append({ id, position.first, position.second });
+                }
+            }
+        }
+    }
+
+    for (const QString &word : std::as_const(touched)) {
+        QList<Occurrence> &occurrences = words[word];
+        std::sort(occurrences.begin(), occurrences.end());
+    }
+
+    if (progress) {
+        progress(changed.size(), changed.size());
+    }
+    return changed.size() + removed;
+}
+
+QList<SearchHit> FolderIndex::search(const QString &query, int limit) const {
+    const bool phrase = query.trimmed().startsWith('"');
+    const QList<Token> terms = tokenize(query);
+    if (terms.isEmpty()) {
+        return QList<SearchHit>();
+    }
+
+    QList<const QList<Occurrence> *> lists;
+    for (const Token &term : terms) {
+        auto it = words.constFind(term.word);
+        if (it == words.cend()) {
+            return QList<SearchHit>();
+        }
+        lists.append(&*it);
+    }
+
+    struct Match
+    {
+        quint32 file = 0;
+        int position = -1;
+        int length = 0;
+        int count = 0;
+    };
+    // In file order, each file at most once.
+    QList<Match> matches;
+
+    if (phrase) {
+        // Walk the rarest word and look the others up at the ordinals the
+        // phrase puts them at.
+        int rarest = 0;
+        for (int i = 1; i < terms.size(); ++i) {
+            if (lists[i]->size() < lists[rarest]->size()) {
+                rarest = i;
+            }
+        }
+
+        for (const Occurrence &occurrence : *lists[rarest]) {
+            if (occurrence.ordinal < quint32(rarest)) {
+                continue;
+            }
+            const quint32 first = occurrence.ordinal - rarest;
+            quint32 start = 0;
+            quint32 end = 0;
+            bool found = true;
+            for (int i = 0; i < terms.size() && found; ++i) {
+                const Occurrence key { occurrence.file, first + i, 0 };
+                auto next = std::lower_bound(lists[i]->cbegin(), lists[i]->cend(), key);
+                found = next != lists[i]->cend() && next->file == key.file && next->ordinal == key.ordinal;
+                if (found && i == 0) {
+                    start = next->offset;
+                }
+                if (found) {
+                    end = next->offset + terms[i].length;
+                }
+            }
+            if (!found) {
+                continue;
+            }
+
+            // Postings are in order, the first match in a file is the earliest.
+            if (matches.isEmpty() || matches.last().file != occurrence.file) {
+                matches.append({ occurrence.file, int(start), int(end - start), 0 });
+            }
+            ++matches.last().count;
+        }
+    } else {
+        // Intersect the files of all words; the postings of one file are
+        // contiguous, so each list is only walked forward.
+        QList<QList<Occurrence>::const_iterator> cursors;
+        for (const QList<Occurrence> *list : lists) {
+            cursors.append(list->cbegin());
+        }
+
+        auto first = lists[0]->cbegin();
+        while (first != lists[0]->cend()) {
+            const quint32 file = first->file;
+            auto last = std::upper_bound(first, lists[0]->cend(), Occurrence { file, std::numeric_limits<quint32>::max(), 0 });
+
+            bool found = true;
+            for (int i = 1; i < terms.size() && found; ++i) {
+                cursors[i] = std::lower_bound(cursors[i], lists[i]->cend(), Occurrence { file, 0, 0 });
+                found = cursors[i] != lists[i]->cend() && cursors[i]->file == file;
+            }
+            if (found) {
+                matches.append({ file, int(first->offset), terms[0].length, int(last - first) });
+            }
+            first = last;
+        }
+    }
+
+    QList<SearchHit> hits;
+    hits.reserve(matches.size());
+    for (const Match &match : std::as_const(matches)) {
+        SearchHit hit;
+        hit.path = QDir(root).filePath(files[match.file].path);
+        hit.position = match.position;
+        hit.length = match.length;
+        hit.count = match.count;
+        hits.append(hit);
+    }
+
+    std::sort(hits.begin(), hits.end(), [](const SearchHit &a, const SearchHit &b) {
+        return a.count != b.count ? a.count > b.count : a.path < b.path;
+    });
+    if (hits.size() > limit) {
+        hits.resize(limit);
+    }
+    return hits;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef FOLDERINDEX_H
+#define FOLDERINDEX_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <functional>
+#include <memory>
+
+struct SearchHit
+{
+    QString path;
+    int position = 0;
+    int length = 0;
+    int count = 0;
+};
+
+// Inverted index over the plain text of the HTML documents in a folder,
+// kept in the cache directory between runs. update() re-reads only the
+// files whose modification time or size changed.
+//
+// The whole index lives in memory, 12 bytes for every word of every file
+// plus the word table, and save() rewrites it as a whole. For a folder with
+// a few hundred megabytes of text that is a few hundred megabytes here and
+// on disk, which is why windows share one instance per folder, see shared().
+//
+// Not thread safe: the owner must not search while update() is running.
+// Searches may run on any thread and in parallel with each other.
+class FolderIndex
+{
+public:
+    explicit FolderIndex(const QString &folder);
+
+    QString folder() const { return root; }
+    int fileCount() const;
+
+    bool load();
+    bool save() const;
+
+    // The index last published for `folder`, as long as some window still
+    // holds it, otherwise null. Copying it to update is cheap, the postings
+    // are shared until they change.
+    static std::shared_ptr<const FolderIndex> shared(const QString &folder);
+    static void setShared(const std::shared_ptr<const FolderIndex> &index);
+
+    // Brings the index up to date with the folder and returns the number of
+    // files that were (re)indexed or removed. `progress` is called from the calling
+    // thread with the number of files done and the total.
+    int update(const std::function<void(int, int)> &progress = nullptr);
+
+    // Words are matched case-insensitively; a query in double quotes must
+    // match as a phrase, otherwise a file has to contain all of its words.
+    QList<SearchHit> search(const QString &query, int limit) const;
+
+private:
+    struct FileEntry
+    {
+        QString path;
+        qint64 modified = 0;
+        qint64 size = 0;
+    };
+
+    struct Occurrence
+    {
+        quint32 file;
+        quint32 ordinal;
+        quint32 offset;
+
+        // Postings of a word are kept in this order.
+        bool operator<(const Occurrence &other) const {
+            return file != other.file ? file < other.file : ordinal < other.ordinal;
+        }
+    };
+
+    QString indexPath() const;
+
+    QString root;
+    QList<FileEntry> files;
+    QHash<QString, QList<Occurrence>> words;
+};
+
+#endif // FOLDERINDEX_H
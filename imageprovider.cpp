@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "imageprovider.h"
+
+#include <QtConcurrent>
+#include <QtMath>
+#include <QThread>
+#include <QBuffer>
+#include <QImageReader>
+#include <QFileInfo>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QAbstractTextDocumentLayout>
+
+static const qint64 kCacheBudget = 128 * 1024 * 1024;
+static const qsizetype kHeaderBytes = 64 * 1024;
+static const int kPlaceholderWidth = 16;
+
+// Local path of an image the same way QTextDocument resolves it, or an
+// empty string for images that are not files (data: URLs, network).
+static QString localPath(const QUrl &url) {
+    if (url.scheme() == "qrc") {
+        return ":" + url.path();
+    }
+    if (url.isLocalFile()) {
+        return url.toLocalFile();
+    }
+    // Relative paths and Windows drive letters, which QUrl takes for a scheme.
+    if (url.scheme().isEmpty() || url.scheme().size() == 1) {
+        return url.toString();
+    }
+    return QString();
+}
+
+static QDateTime lastModified(const QUrl &url) {
+    QString path = localPath(url);
+    return path.isEmpty() ? QDateTime() : QFileInfo(path).lastModified();
+}
+
+// Payload of a data: URL. With `maxBytes` only about that much is decoded,
+// which is enough for the image header.
+static QByteArray dataUrlBytes(const QUrl &url, qsizetype maxBytes = -1) {
+    const QString path = url.path(QUrl::FullyEncoded);
+    qsizetype comma = path.indexOf(',');
+    if (comma < 0) {
+        return QByteArray();
+    }
+
+    const bool base64 = path.left(comma).endsWith(";base64");
+    qsizetype length = -1;
+    if (base64 && maxBytes > 0) {
+        length = maxBytes / 3 * 4;
+    }
+
+    QByteArray payload = QByteArray::fromPercentEncoding(path.mid(comma + 1, length).toLatin1());
+    if (!base64) {
+        return payload;
+    }
+    if (length >= 0) {
+        payload.truncate(payload.size() & ~3);
+    }
+    return QByteArray::fromBase64(payload);
+}
+
+static QSize readSize(const QUrl &url) {
+    if (url.scheme() == "data") {
+        QByteArray data = dataUrlBytes(url, kHeaderBytes);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        QSize size = QImageReader(&buffer).size();
+        if (size.isValid()) {
+            return size;
+        }
+        buffer.close();
+        data = dataUrlBytes(url);
+        buffer.open(QIODevice::ReadOnly);
+        return QImageReader(&buffer).size();
+    }
+
+    QString path = localPath(url);
+    if (path.isEmpty()) {
+        return QSize();
+    }
+    return QImageReader(path).size();
+}
+
+static QImage decodeImage(const QUrl &url, const QSize &naturalSize, const QSize &target) {
+    QByteArray data;
+    QBuffer buffer(&data);
+    QImageReader reader;
+
+    if (url.scheme() == "data") {
+        data = dataUrlBytes(url);
+        buffer.open(QIODevice::ReadOnly);
+        reader.setDevice(&buffer);
+    } else {
+        reader.setFileName(localPath(url));
+    }
+
+    // Decoders such as JPEG can scale while decoding, so the full-size image
+    // is never allocated.
+    if (target != naturalSize) {
+        reader.setScaledSize(target);
+    }
+
+    QImage image = reader.read();
+    if (!image.isNull()) {
+        image.setDevicePixelRatio(qreal(image.width()) / naturalSize.width());
+    }
+    return image;
+}
+
+ImageProvider::ImageProvider(TextEditor *_textEdit, QObject *parent)
+    : QObject(parent), textEdit(_textEdit)
+{
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+
+    scheduleTimer = new QTimer(this);
+    scheduleTimer->setSingleShot(true);
+    scheduleTimer->setInterval(50);
+    connect(scheduleTimer, &QTimer::timeout, this, &ImageProvider::scheduleVisible);
+
+    connect(textEdit->verticalScrollBar(), &QScrollBar::valueChanged, scheduleTimer, qOverload<>(&QTimer::start));
+    connect(textEdit->document()->documentLayout(), &QAbstractTextDocumentLayout::documentSizeChanged,
+            scheduleTimer, qOverload<>(&QTimer::start));
+
+    textEdit->setResourceLoader([this](int type, const QUrl &name) {
+        return type == QTextDocument::ImageResource ? load(resolve(name)) : QVariant();
+    });
+}
+
+ImageProvider::~ImageProvider() {
+    pool.clear();
+    pool.waitForDone();
+}
+
+void ImageProvider::clear() {
+    // Invalid resources make the document ask the provider again. Decodes
+    // still running are dropped in decoded() as their entries are gone.
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        textEdit->document()->addResource(QTextDocument::ImageResource, it.key(), QVariant());
+    }
+    entries.clear();
+    decodedBytes = 0;
+}
+
+void ImageProvider::refresh() {
+    // The document keeps the resources it was given across a reload, so
+    // images rewritten under the same name are replaced here.
+    bool resized = false;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        QDateTime modified = lastModified(it.key());
+        if (modified == it->modified) {
+            continue;
+        }
+        it->modified = modified;
+
+        QSize size = readSize(it.key());
+        if (size.isValid() && !size.isEmpty() && size != it->naturalSize) {
+            it->naturalSize = size;
+            resized = true;
+        }
+
+        // A decode still running is for the old file, see decoded().
+        decodedBytes -= it->bytes;
+        it->bytes = 0;
+        it->generation = ++clock;
+        it->state = size.isValid() && !size.isEmpty() ? State::Placeholder : State::Failed;
+        textEdit->document()->addResource(QTextDocument::ImageResource, it.key(), placeholder(it->naturalSize));
+    }
+
+    if (resized) {
+        QTextDocument *document = textEdit->document();
+        document->markContentsDirty(0, document->characterCount());
+    }
+    scheduleTimer->start();
+}
+
+qint64 ImageProvider::cacheBytes() const {
+    return decodedBytes;
+}
+
+// Images are keyed by the URL QTextDocument looks them up with.
+QUrl ImageProvider::resolve(const QUrl &name) const {
+    return textEdit->document()->baseUrl().resolved(name);
+}
+
+QVariant ImageProvider::load(const QUrl &url) {
+    auto it = entries.find(url);
+    if (it == entries.end()) {
+        QSize size = readSize(url);
+        if (!size.isValid() || size.isEmpty()) {
+            // Unknown format, leave it to QTextDocument.
+            return QVariant();
+        }
+        it = entries.insert(url, Entry());
+        it->naturalSize = size;
+        it->modified = lastModified(url);
+    } else if (it->state == State::Failed) {
+        return QVariant();
+    }
+
+    // Registered with the document so it is not asked for this image again;
+    // a decode already running or finished replaces the placeholder itself.
+    QImage image = placeholder(it->naturalSize);
+    if (it->state == State::Placeholder) {
+        textEdit->document()->addResource(QTextDocument::ImageResource, url, image);
+    }
+    scheduleTimer->start();
+
+    return image;
+}
+
+void ImageProvider::scheduleVisible() {
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    // Everything on screen plus one screen above and below.
+    QRect area = textEdit->viewport()->rect();
+    area.adjust(0, -area.height(), 0, area.height());
+    int start = textEdit->cursorForPosition(area.topLeft()).position();
+    int end = textEdit->cursorForPosition(area.bottomRight()).position();
+
+    lastScan = ++clock;
+    QTextDocument *document = textEdit->document();
+    for (QTextBlock block = document->findBlock(start); block.isValid() && block.position() <= end; block = block.next()) {
+        for (QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it) {
+            QTextCharFormat format = it.fragment().charFormat();
+            if (format.isImageFormat()) {
+                QTextImageFormat imageFormat = format.toImageFormat();
+                request(resolve(QUrl(imageFormat.name())), imageFormat);
+            }
+        }
+    }
+
+    trim();
+}
+
+void ImageProvider::request(const QUrl &url, const QTextImageFormat &format) {
+    auto it = entries.find(url);
+    if (it == entries.end()) {
+        return;
+    }
+
+    it->lastUse = lastScan;
+    if (it->state != State::Placeholder) {
+        return;
+    }
+
+    it->state = State::Decoding;
+    quint64 generation = it->generation = ++clock;
+    QSize naturalSize = it->naturalSize;
+    QSize target = targetSize(*it, format);
+
+    QtConcurrent::run(&pool, [url, naturalSize, target]() {
+        return decodeImage(url, naturalSize, target);
+    }).then(this, [this, url, generation](const QImage &image) {
+        decoded(url, generation, image);
+    });
+}
+
+void ImageProvider::decoded(const QUrl &url, quint64 generation, const QImage &image) {
+    auto it = entries.find(url);
+    if (it == entries.end() || it->generation != generation) {
+        return;
+    }
+
+    if (image.isNull()) {
+        it->state = State::Failed;
+        return;
+    }
+
+    it->state = State::Decoded;
+    it->bytes = image.sizeInBytes();
+    decodedBytes += it->bytes;
+
+    textEdit->document()->addResource(QTextDocument::ImageResource, url, image);
+    textEdit->viewport()->update();
+    trim();
+}
+
+void ImageProvider::trim() {
+    while (decodedBytes > kCacheBudget) {
+        auto oldest = entries.end();
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->state == State::Decoded && it->lastUse < lastScan
+                && (oldest == entries.end() || it->lastUse < oldest->lastUse)) {
+                oldest = it;
+            }
+        }
+        // Whatever is left is near the viewport.
+        if (oldest == entries.end()) {
+            return;
+        }
+
+        textEdit->document()->addResource(QTextDocument::ImageResource, oldest.key(), placeholder(oldest->naturalSize));
+        decodedBytes -= oldest->bytes;
+        oldest->bytes = 0;
+        oldest->state = State::Placeholder;
+    }
+}
+
+QSize ImageProvider::targetSize(const Entry &entry, const QTextImageFormat &format) const {
+    const QSize natural = entry.naturalSize;
+    const bool hasWidth = format.hasProperty(QTextFormat::ImageWidth);
+    const bool hasHeight = format.hasProperty(QTextFormat::ImageHeight);
+
+    QSizeF display = natural;
+    if (hasWidth && hasHeight) {
+        display = QSizeF(format.width(), format.height());
+    } else if (hasWidth) {
+        display = QSizeF(format.width(), format.width() * natural.height() / natural.width());
+    } else if (hasHeight) {
+        display = QSizeF(format.height() * natural.width() / natural.height(), format.height());
+    }
+
+    display *= textEdit->devicePixelRatioF();
+    QSize target(qMin(natural.width(), qCeil(display.width())), qMin(natural.height(), qCeil(display.height())));
+    return target.expandedTo(QSize(1, 1));
+}
+
+QImage ImageProvider::placeholder(const QSize &naturalSize) {
+    // Device pixel ratio below one keeps the layout size of the real image.
+    int width = qMin(naturalSize.width(), kPlaceholderWidth);
+    qreal ratio = qreal(width) / naturalSize.width();
+    int height = qMax(1, qRound(naturalSize.height() * ratio));
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(QColor(0, 0, 0, 20));
+    image.setDevicePixelRatio(ratio);
+    return image;
+}
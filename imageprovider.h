@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef IMAGEPROVIDER_H
+#define IMAGEPROVIDER_H
+
+#include <QObject>
+#include "texteditor.h"
+
+#include <QTextImageFormat>
+#include <QThreadPool>
+#include <QHash>
+#include <QImage>
+#include <QTimer>
+#include <QUrl>
+#include <QDateTime>
+
+// Resource provider for the images of a QTextEdit document. Images first get
+// a tiny placeholder of the right size, are decoded on a thread pool once
+// they come close to the viewport, downscaled to the size they are shown at,
+// and dropped again least recently used first when over the memory budget.
+class ImageProvider : public QObject
+{
+    Q_OBJECT
+public:
+    ImageProvider(TextEditor *textEdit, QObject *parent);
+    ~ImageProvider();
+
+    // Forgets all images, call before loading a new document.
+    void clear();
+
+    // Reloads the images whose files changed since they were read, call
+    // after the document was reloaded from disk.
+    void refresh();
+
+    qint64 cacheBytes() const;
+
+private:
+    enum class State { Placeholder, Decoding, Decoded, Failed };
+
+    struct Entry
+    {
+        QSize naturalSize;
+        QDateTime modified;
+        State state = State::Placeholder;
+        qint64 bytes = 0;
+        quint64 lastUse = 0;
+        quint64 generation = 0;
+    };
+
+    QUrl resolve(const QUrl &name) const;
+    QVariant load(const QUrl &url);
+    void scheduleVisible();
+    void request(const QUrl &url, const QTextImageFormat &format);
+    void decoded(const QUrl &url, quint64 generation, const QImage &image);
+    void trim();
+
+    QSize targetSize(const Entry &entry, const QTextImageFormat &format) const;
+    static QImage placeholder(const QSize &naturalSize);
+
+    TextEditor* textEdit;
+    QThreadPool pool;
+    QTimer* scheduleTimer;
+    QHash<QUrl, Entry> entries;
+    qint64 decodedBytes = 0;
+    quint64 clock = 0;
+    quint64 lastScan = 0;
+};
+
+#endif // IMAGEPROVIDER_H
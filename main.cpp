@@ -20,9 +20,13 @@
  * THE SOFTWARE.
 */
 #include "mainwindow.h"
+#include "memorywindow.h"
 
 #include <QApplication>
 #include <QCommandLineParser>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QTimer>
 
 int main(int argc, char *argv[])
 {
@@ -32,7 +36,15 @@ int main(int argc, char *argv[])
     QCommandLineParser parser;
     parser.setApplicationDescription("Text Editor");
     parser.addHelpOption();
-    parser.addPositionalArgument("file", "The file to open.");
+    parser.addPositionalArgument("file", "The file to open (.html, .html.gz or .html.zst).");
+
+    QCommandLineOption memoryReportOption("memory-report",
+                                          "Print a memory usage report after loading the file and exit.");
+    parser.addOption(memoryReportOption);
+    QCommandLineOption memoryLogOption("memory-log",
+                                       "Print a memory usage report to stdout every <seconds>.",
+                                       "seconds");
+    parser.addOption(memoryLogOption);
 
     // Парсимо аргументи
     parser.process(a);
@@ -45,5 +57,32 @@ int main(int argc, char *argv[])
     MainWindow w(filePath);
     w.show();
 
+    // Звіт про використання пам'яті для моніторингу
+    auto printMemoryReport = [](){
+        QTextStream out(stdout);
+        out << MemoryWindow::report() << Qt::endl;
+    };
+
+    if (parser.isSet(memoryReportOption)) {
+        // exit() а не quit(): quit() спершу закриває вікна і може спитати про збереження
+        auto reportAndQuit = [&](){
+            printMemoryReport();
+            QCoreApplication::exit(0);
+        };
+        // Файл читається у фоновому потоці, чекаємо поки він завантажиться
+        if (QFileInfo::exists(filePath)) {
+            QObject::connect(&w, &MainWindow::fileLoaded, &a, reportAndQuit, Qt::QueuedConnection);
+        } else {
+            QTimer::singleShot(0, &a, reportAndQuit);
+        }
+    }
+
+    int memoryLogSeconds = parser.value(memoryLogOption).toInt();
+    if (memoryLogSeconds > 0) {
+        QTimer* memoryLogTimer = new QTimer(&a);
+        QObject::connect(memoryLogTimer, &QTimer::timeout, &a, printMemoryReport);
+        memoryLogTimer->start(memoryLogSeconds * 1000);
+    }
+
     return a.exec();
 }
@@ -22,9 +22,13 @@
 #include "mainwindow.h"
 #include "contactswindow.h"
 #include "aboutwindow.h"
+#include "memorywindow.h"
+#include "compressedio.h"
+#include "searchwindow.h"
 
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QMenuBar>
 #include <QColorDialog>
 #include <QFontDialog>
@@ -37,7 +41,7 @@
 #include <QPrintDialog>
 
 MainWindow::MainWindow(const QString &_filePath, QWidget *parent)
-    : QMainWindow(parent), filePath(_filePath.isEmpty() ? "none" : _filePath)
+    : QMainWindow(parent), filePath(_filePath.isEmpty() || QFileInfo::exists(_filePath) ? "none" : _filePath)
 {
     setMinimumSize(400, 300);
     resize(640, 480);
@@ -49,21 +53,35 @@ MainWindow::MainWindow(const QString &_filePath, QWidget *parent)
     layout = new QVBoxLayout(centralWidget);
     layout->setContentsMargins(0,0,0,0);
 
-    textEdit = new QTextEdit();
+    textEdit = new TextEditor();
     textEdit->setAcceptRichText(true);
     connect(textEdit, &QTextEdit::textChanged, this, [this](){
         setWindowTitle(filePath + "*");
         isSaving = false;
     });
 
+    // The undo history keeps removed text alive; it is freed only with the
+    // history, which loading a document clears.
+    connect(textEdit->document(), &QTextDocument::contentsChange, this, [this](int, int removed, int){
+        QTextDocument *document = textEdit->document();
+        bool history = document->availableUndoSteps() + document->availableRedoSteps() > 0;
+        removedCharacters = history ? removedCharacters + removed : 0;
+    });
+
     layout->addWidget(textEdit);
 
-    if (!filePath.isEmpty() && filePath != "none") {
-        QFile file(filePath);
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            textEdit->setHtml(file.readAll());
-            file.close();
-        }
+    imageProvider = new ImageProvider(textEdit, this);
+    spellChecker = new SpellChecker(textEdit, this);
+
+    reloader = new FileReloader(textEdit, this);
+    connect(reloader, &FileReloader::reloaded, this, [this](){
+        imageProvider->refresh();
+        setWindowTitle(filePath);
+        isSaving = true;
+    });
+
+    if (!_filePath.isEmpty() && QFileInfo::exists(_filePath)) {
+        loadFile(_filePath);
     }
 
     setupMenu();
@@ -71,6 +89,26 @@ MainWindow::MainWindow(const QString &_filePath, QWidget *parent)
 
 MainWindow::~MainWindow() {}
 
+DocumentMemory MainWindow::memoryUsage() {
+    lastMemoryUsage.name = filePath;
+    lastMemoryUsage.cacheBytes = reloader->cacheBytes();
+    lastMemoryUsage.removedCharacters = removedCharacters;
+    lastMemoryUsage = MemoryReport::measure(textEdit->document(), lastMemoryUsage);
+    // Decoded images are document resources, so they count as images and
+    // not as a cache next to the document.
+    lastMemoryUsage.imageBytes = imageProvider->cacheBytes();
+    return lastMemoryUsage;
+}
+
+void MainWindow::selectText(int position, int length) {
+    int last = textEdit->document()->characterCount() - 1;
+    QTextCursor cursor(textEdit->document());
+    cursor.setPosition(qMin(position, last));
+    cursor.setPosition(qMin(position + length, last), QTextCursor::KeepAnchor);
+    textEdit->setTextCursor(cursor);
+    textEdit->ensureCursorVisible();
+}
+
 void MainWindow::closeEvent(QCloseEvent *event) {
     if (!isSaving) {
         QMessageBox::StandardButton reply;
@@ -94,6 +132,8 @@ void MainWindow::setupMenu() {
     fileMenu->addSeparator();
     fileMenu->addAction("&Export as text", this, &MainWindow::exportAsPlainText);
     fileMenu->addSeparator();
+    fileMenu->addAction(QIcon::fromTheme(QIcon::ThemeIcon::EditFind), "Search in &folder", this, &MainWindow::showSearch)->setShortcut(QKeySequence("Ctrl+Shift+F"));
+    fileMenu->addSeparator();
     fileMenu->addAction(QIcon::fromTheme(QIcon::ThemeIcon::Printer), "&Print", this, &MainWindow::print)->setShortcut(QKeySequence::Print);
     fileMenu->addSeparator();
     fileMenu->addAction(QIcon::fromTheme(QIcon::ThemeIcon::ApplicationExit), "&Exit", this, &QMainWindow::close)->setShortcut(QKeySequence::Quit);
@@ -121,6 +161,12 @@ void MainWindow::setupMenu() {
     QAction* selectAllAction = editMenu->addAction(QIcon::fromTheme(QIcon::ThemeIcon::EditSelectAll), "&Select all", this, [this](){ textEdit->selectAll(); });
     selectAllAction->setShortcut(QKeySequence::SelectAll);
 
+    editMenu->addSeparator();
+
+    QAction* spellAction = editMenu->addAction(QIcon::fromTheme(QIcon::ThemeIcon::ToolsCheckSpelling), "Check &spelling", this, [this](bool checked){ spellChecker->setEnabled(checked); });
+    spellAction->setCheckable(true);
+    spellAction->setChecked(spellChecker->isEnabled());
+
     QMenu* formatMenu = menuBar()->addMenu("&Format");
     formatMenu->addAction(QIcon::fromTheme(QIcon::ThemeIcon::FormatTextBold), "&Bold", this, &MainWindow::bold)->setShortcut(QKeySequence::Bold);
     formatMenu->addAction(QIcon::fromTheme(QIcon::ThemeIcon::FormatTextItalic), "&Italic", this, &MainWindow::italic)->setShortcut(QKeySequence::Italic);
@@ -142,6 +188,7 @@ void MainWindow::setupMenu() {
 
     QMenu* helpMenu = menuBar()->addMenu("&Help");
     helpMenu->addAction("&Contacts", this, &MainWindow::showContacts);
+    helpMenu->addAction("&Memory usage", this, &MainWindow::showMemoryUsage);
     helpMenu->addSeparator();
     helpMenu->addAction(QIcon::fromTheme(QIcon::ThemeIcon::HelpAbout), "&About", this, &MainWindow::showAbout);
 }
@@ -214,39 +261,101 @@ void MainWindow::setAlign(Qt::Alignment align) {
 }
 
 void MainWindow::newFile() {
+    ++loadGeneration;
+    textEdit->setReadOnly(false);
     filePath = "none";
+    imageProvider->clear();
     textEdit->setHtml("");
+    reloader->watch(QString());
 }
 
 void MainWindow::openFile() {
     QStringList filters = {
         "HTML (*.html)",
+        "Compressed HTML (*.html.gz *.html.zst)",
         "All Files (*)"
     };
 
-    filePath = QFileDialog::getOpenFileName(
+    QString path = QFileDialog::getOpenFileName(
         this,
         "Open HTML File",
         QDir::homePath(),
         filters.join(";;")
         );
 
-    if (!filePath.isEmpty()) {
-        QFile file(filePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QMessageBox::critical(this, "Error", "Could not open file:");
+    if (!path.isEmpty()) {
+        loadFile(path);
+    }
+}
+
+void MainWindow::loadFile(const QString &path) {
+    // filePath switches only once the text is in, until then saving writes
+    // the current document to its own file. Edits would be lost, so block them.
+    int generation = ++loadGeneration;
+    textEdit->setReadOnly(true);
+
+    CompressedIO::readTextAsync(path).then(this, [this, path, generation](const CompressedIO::Result &result){
+        if (generation != loadGeneration) {
             return;
         }
-        QTextStream in(&file);
-        QString text = in.readAll();
-        textEdit->setHtml(text);
+        textEdit->setReadOnly(false);
+
+        if (!result.ok()) {
+            QMessageBox::critical(this, "Error", result.error);
+        } else {
+            filePath = path;
+            imageProvider->clear();
+            textEdit->setHtml(result.text);
+            // Freshly read, nothing to save yet.
+            setWindowTitle(filePath);
+            isSaving = true;
+            reloader->watch(filePath);
+        }
+        emit fileLoaded();
+    });
+}
+
+void MainWindow::writeHtml(const QString &path) {
+    // One save at a time; a save requested meanwhile runs afterwards and
+    // writes whatever the document holds by then.
+    if (isWriting) {
+        queuedWrite = path;
+        return;
     }
+    isWriting = true;
+
+    int revision = textEdit->document()->revision();
+
+    // Our own write must not be picked up as an external change.
+    reloader->watch(QString());
+
+    CompressedIO::writeTextAsync(path, textEdit->toHtml()).then(this, [this, path, revision](const QString &error){
+        isWriting = false;
+        if (!queuedWrite.isEmpty()) {
+            QString next = queuedWrite;
+            queuedWrite.clear();
+            writeHtml(next);
+        } else if (path == filePath) {
+            // What was typed during the write is not in the file.
+            reloader->watch(filePath, revision);
+        }
+
+        if (!error.isEmpty()) {
+            QMessageBox::critical(this, "Error", error);
+            return;
+        }
+        if (path == filePath && textEdit->document()->revision() == revision) {
+            isSaving = true;
+            setWindowTitle(filePath);
+        }
+    });
 }
 
 void MainWindow::saveFile() {
     if (filePath.isEmpty() || filePath == "none") {
         QStringList filters = {
             "HTML (*.html)",
+            "Compressed HTML (*.html.gz *.html.zst)",
             "All Files (*)"
         };
 
@@ -262,22 +371,13 @@ void MainWindow::saveFile() {
         }
     }
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, "Error", "Could not save file!");
-        return;
-    }
-
-    QTextStream out(&file);
-    out << textEdit->toHtml();
-    file.close();
-    isSaving = true;
-    setWindowTitle(filePath);
+    writeHtml(filePath);
 }
 
 void MainWindow::saveAsFile() {
     QStringList filters = {
         "HTML (*.html)",
+        "Compressed HTML (*.html.gz *.html.zst)",
         "All Files (*)"
     };
 
@@ -294,22 +394,13 @@ void MainWindow::saveAsFile() {
         return;
     }
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, "Error", "Could not save file!");
-        return;
-    }
-
-    QTextStream out(&file);
-    out << textEdit->toHtml();
-    file.close();
-    isSaving = true;
-    setWindowTitle(filePath);
+    writeHtml(filePath);
 }
 
 void MainWindow::exportAsPlainText() {
     QStringList filters = {
         "Text files (*.txt)",
+        "Compressed text files (*.txt.gz *.txt.zst)",
         "All Files (*)"
     };
 
@@ -324,15 +415,11 @@ void MainWindow::exportAsPlainText() {
         return;
     }
 
-    QFile file(eFilePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::critical(this, "Error", "Could not save file!");
-        return;
-    }
-
-    QTextStream out(&file);
-    out << textEdit->toPlainText();
-    file.close();
+    CompressedIO::writeTextAsync(eFilePath, textEdit->toPlainText()).then(this, [this](const QString &error){
+        if (!error.isEmpty()) {
+            QMessageBox::critical(this, "Error", error);
+        }
+    });
 }
 
 void MainWindow::print() {
@@ -341,7 +428,10 @@ void MainWindow::print() {
     QPrintDialog printDialog(&printer, this);
 
     if (printDialog.exec() == QDialog::Accepted) {
+        // A separate document without the image provider, so the printout
+        // gets images at full resolution instead of the on-screen copies.
         QTextDocument document;
+        document.setBaseUrl(textEdit->document()->baseUrl());
         document.setHtml(text);
         document.print(&printer);
     }
@@ -481,3 +571,13 @@ void MainWindow::showAbout() {
     AboutWindow* ab = new AboutWindow();
     ab->show();
 }
+
+void MainWindow::showMemoryUsage() {
+    MemoryWindow* mw = new MemoryWindow();
+    mw->show();
+}
+
+void MainWindow::showSearch() {
+    SearchWindow* sw = new SearchWindow();
+    sw->show();
+}
@@ -26,6 +26,12 @@
 #include <QMainWindow>
 #include <QVBoxLayout>
 
+#include "memoryreport.h"
+#include "filereloader.h"
+#include "imageprovider.h"
+#include "spellchecker.h"
+#include "texteditor.h"
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -34,6 +40,12 @@ public:
     explicit MainWindow(const QString &filePath = QString(), QWidget *parent = nullptr);
     ~MainWindow();
 
+    DocumentMemory memoryUsage();
+    void selectText(int position, int length);
+
+signals:
+    void fileLoaded();
+
 private:
     void closeEvent(QCloseEvent *event) override;
     void setupMenu();
@@ -43,6 +55,8 @@ private:
     void saveFile();
     void saveAsFile();
     void exportAsPlainText();
+    void loadFile(const QString &path);
+    void writeHtml(const QString &path);
     void print();
 
     void bold();
@@ -60,12 +74,22 @@ private:
 
     void showContacts();
     void showAbout();
+    void showMemoryUsage();
+    void showSearch();
 
     void setFormatMacro(std::function<void> func);
 
     bool isSaving = true;
     QString filePath = "none";
+    int loadGeneration = 0;
+    bool isWriting = false;
+    QString queuedWrite;
     QVBoxLayout* layout;
-    QTextEdit* textEdit;
+    TextEditor* textEdit;
+    FileReloader* reloader;
+    ImageProvider* imageProvider;
+    SpellChecker* spellChecker;
+    DocumentMemory lastMemoryUsage;
+    qint64 removedCharacters = 0;
 };
 #endif // MAINWINDOW_H
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "memoryreport.h"
+
+#include <QTextBlock>
+#include <QTextLayout>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLocale>
+#include <QSet>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+// Rough per-object costs of QTextDocument internals that are not visible
+// through the public API.
+static const qint64 kFragmentBytes = 48;
+static const qint64 kFormatPropertyBytes = 32;
+static const qint64 kLayoutBlockBytes = 400;
+static const qint64 kLayoutLineBytes = 96;
+static const qint64 kUndoStepBytes = 64;
+
+// A walk may take at most 1/kWalkShare of the time, and run at most every
+// kWalkInterval milliseconds.
+static const qint64 kWalkInterval = 10000;
+static const qint64 kWalkShare = 50;
+
+static qint64 monotonicMs() {
+    static QElapsedTimer clock;
+    if (!clock.isValid()) {
+        clock.start();
+    }
+    return clock.elapsed();
+}
+
+qint64 DocumentMemory::total() const {
+    return textBytes + formatBytes + layoutBytes + undoBytes + imageBytes + cacheBytes;
+}
+
+DocumentMemory MemoryReport::measure(QTextDocument *document, const DocumentMemory &previous) {
+    DocumentMemory memory;
+    memory.name = previous.name;
+    memory.cacheBytes = previous.cacheBytes;
+    memory.removedCharacters = previous.removedCharacters;
+    memory.revision = document->revision();
+    memory.layoutWidth = document->textWidth();
+    memory.undoSteps = document->availableUndoSteps();
+    memory.redoSteps = document->availableRedoSteps();
+    memory.characters = document->characterCount();
+    memory.blocks = document->blockCount();
+
+    // Removed text stays in the document's buffer while undo can bring it back.
+    memory.undoBytes = (memory.undoSteps + memory.redoSteps) * kUndoStepBytes
+                       + memory.removedCharacters * qint64(sizeof(QChar));
+
+    const qint64 now = monotonicMs();
+    const bool changed = previous.revision != memory.revision || previous.layoutWidth != memory.layoutWidth;
+    const bool throttled = previous.walkedAt >= 0
+                           && now - previous.walkedAt < qMax(kWalkInterval, previous.walkMs * kWalkShare);
+
+    if (!changed || throttled) {
+        // Keep the revision of the last walk so the next poll walks again
+        // once the interval is over.
+        memory.revision = previous.revision;
+        memory.layoutWidth = previous.layoutWidth;
+        memory.walkedAt = previous.walkedAt;
+        memory.walkMs = previous.walkMs;
+        memory.fragments = previous.fragments;
+        memory.formats = previous.formats;
+        memory.formatBytes = previous.formatBytes;
+        memory.layoutLines = previous.layoutLines;
+        memory.layoutBytes = previous.layoutBytes;
+        memory.images = previous.images;
+        memory.textBytes = memory.characters * qint64(sizeof(QChar))
+                           + (memory.fragments + memory.blocks) * kFragmentBytes;
+        return memory;
+    }
+
+    memory.walkedAt = now;
+
+    QSet<QString> imageNames;
+    int laidOutBlocks = 0;
+    for (QTextBlock block = document->begin(); block.isValid(); block = block.next()) {
+        QTextLayout *layout = block.layout();
+        if (layout && layout->lineCount() > 0) {
+            ++laidOutBlocks;
+            memory.layoutLines += layout->lineCount();
+        }
+
+        for (QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it) {
+            QTextFragment fragment = it.fragment();
+            if (!fragment.isValid()) {
+                continue;
+            }
+            ++memory.fragments;
+
+            QTextCharFormat format = fragment.charFormat();
+            if (format.isImageFormat()) {
+                imageNames.insert(format.toImageFormat().name());
+            }
+        }
+    }
+
+    memory.images = imageNames.size();
+
+    const QList<QTextFormat> formats = document->allFormats();
+    memory.formats = formats.size();
+    foreach (const QTextFormat &format, formats) {
+        memory.formatBytes += kFormatPropertyBytes * (1 + format.properties().size());
+    }
+
+    memory.textBytes = memory.characters * qint64(sizeof(QChar))
+                       + (memory.fragments + memory.blocks) * kFragmentBytes;
+    memory.layoutBytes = laidOutBlocks * kLayoutBlockBytes + memory.layoutLines * kLayoutLineBytes;
+    memory.walkMs = monotonicMs() - now;
+
+    return memory;
+}
+
+qint64 MemoryReport::processRss() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.WorkingSetSize);
+    }
+    return -1;
+#elif defined(Q_OS_LINUX)
+    QFile file("/proc/self/statm");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = file.readAll().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+QString MemoryReport::formatBytes(qint64 bytes) {
+    if (bytes < 0) {
+        return "unknown";
+    }
+    return QLocale::c().formattedDataSize(bytes);
+}
+
+static QString row(const QString &label, const QString &value, const QString &detail = QString()) {
+    QString line = QString("  %1 %2").arg(label, -12).arg(value, -12);
+    if (detail.isEmpty()) {
+        return line.trimmed().prepend("  ") + "\n";
+    }
+    return line + " " + detail + "\n";
+}
+
+QString MemoryReport::format(const QList<DocumentMemory> &documents, qint64 rss) {
+    QString report;
+    qint64 documentsTotal = 0;
+
+    foreach (const DocumentMemory &memory, documents) {
+        report += "[" + memory.name + "]\n";
+        report += row("text", formatBytes(memory.textBytes), QString("%1 chars").arg(memory.characters));
+        report += row("blocks", QString::number(memory.blocks));
+        report += row("fragments", QString::number(memory.fragments));
+        report += row("formats", QString::number(memory.formats), formatBytes(memory.formatBytes));
+        report += row("layout", formatBytes(memory.layoutBytes), QString("%1 lines").arg(memory.layoutLines));
+        report += row("undo", formatBytes(memory.undoBytes),
+                      QString("%1 steps, %2 redo").arg(memory.undoSteps).arg(memory.redoSteps));
+        report += row("images", QString::number(memory.images), formatBytes(memory.imageBytes));
+        report += row("caches", formatBytes(memory.cacheBytes));
+        report += row("estimated", formatBytes(memory.total()), QString("%1 bytes").arg(memory.total()));
+        report += "\n";
+        documentsTotal += memory.total();
+    }
+
+    report += "[process]\n";
+    report += row("windows", QString::number(documents.size()));
+    report += row("documents", formatBytes(documentsTotal), QString("%1 bytes").arg(documentsTotal));
+    report += row("rss", formatBytes(rss), QString("%1 bytes").arg(rss));
+    if (rss >= 0) {
+        qint64 other = rss - documentsTotal;
+        report += row("other", formatBytes(qMax<qint64>(other, 0)), QString("%1 bytes").arg(other));
+    }
+
+    return report;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <QString>
+#include <QList>
+#include <QTextDocument>
+
+// Approximate memory usage of a single document. Sizes are estimates built
+// from what QTextDocument exposes publicly, good enough to find the window
+// that is eating memory, not to account for every byte.
+struct DocumentMemory
+{
+    QString name;
+    int revision = -1;
+    qreal layoutWidth = -1;
+    qint64 walkedAt = -1;
+    qint64 walkMs = 0;
+
+    qint64 characters = 0;
+    qint64 textBytes = 0;
+    int blocks = 0;
+    int fragments = 0;
+    int formats = 0;
+    qint64 formatBytes = 0;
+    int layoutLines = 0;
+    qint64 layoutBytes = 0;
+    int undoSteps = 0;
+    int redoSteps = 0;
+    qint64 removedCharacters = 0;
+    qint64 undoBytes = 0;
+    int images = 0;
+    qint64 imageBytes = 0;
+    qint64 cacheBytes = 0;
+
+    qint64 total() const;
+};
+
+namespace MemoryReport
+{
+    // Walks the document once; reuses `previous` when neither the content
+    // nor the layout width changed since it was taken. While a document is
+    // being edited the walk runs at most every few seconds, scaled by how
+    // long the last walk took, and only cheap counters are refreshed in
+    // between. Image resources are not looked up, that would load them, so
+    // `imageBytes` is left for the owner of the images to fill in.
+    // `removedCharacters` (text deleted since the undo history began, which
+    // the document keeps for undo) is taken from `previous` as well.
+    DocumentMemory measure(QTextDocument *document, const DocumentMemory &previous = DocumentMemory());
+
+    // Resident set size of the whole process, or -1 if the platform is not supported.
+    qint64 processRss();
+
+    QString format(const QList<DocumentMemory> &documents, qint64 rss);
+    QString formatBytes(qint64 bytes);
+}
+
+#endif // MEMORYREPORT_H
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "memorywindow.h"
+#include "mainwindow.h"
+#include "memoryreport.h"
+
+#include <QApplication>
+#include <QFontDatabase>
+#include <QScrollBar>
+
+MemoryWindow::MemoryWindow(QWidget *parent) : QWidget(parent) {
+    setWindowTitle("Memory usage");
+    setAttribute(Qt::WA_DeleteOnClose);
+    resize(420, 480);
+
+    layout = new QVBoxLayout();
+    layout->setContentsMargins(0, 0, 0, 0);
+    setLayout(layout);
+
+    text = new QPlainTextEdit(this);
+    text->setReadOnly(true);
+    text->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    layout->addWidget(text);
+
+    timer = new QTimer(this);
+    timer->setInterval(2000);
+    connect(timer, &QTimer::timeout, this, &MemoryWindow::refresh);
+    timer->start();
+
+    refresh();
+}
+
+MemoryWindow::~MemoryWindow() {}
+
+QString MemoryWindow::report() {
+    QList<DocumentMemory> documents;
+    foreach (QWidget *widget, QApplication::topLevelWidgets()) {
+        MainWindow *window = qobject_cast<MainWindow*>(widget);
+        if (window) {
+            documents.append(window->memoryUsage());
+        }
+    }
+    return MemoryReport::format(documents, MemoryReport::processRss());
+}
+
+void MemoryWindow::refresh() {
+    int scroll = text->verticalScrollBar()->value();
+    text->setPlainText(report());
+    text->verticalScrollBar()->setValue(scroll);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef MEMORYWINDOW_H
+#define MEMORYWINDOW_H
+
+#include <QWidget>
+#include <QPlainTextEdit>
+#include <QVBoxLayout>
+#include <QTimer>
+
+class MemoryWindow : public QWidget
+{
+    Q_OBJECT
+public:
+    MemoryWindow(QWidget *parent = nullptr);
+    ~MemoryWindow();
+
+    // Memory report covering every open MainWindow.
+    static QString report();
+private:
+    void refresh();
+
+    QVBoxLayout* layout;
+    QPlainTextEdit* text;
+    QTimer* timer;
+};
+
+#endif // MEMORYWINDOW_H
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "searchwindow.h"
+#include "mainwindow.h"
+
+#include <QtConcurrent>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QHBoxLayout>
+
+enum HitRole {
+    PathRole = Qt::UserRole,
+    PositionRole,
+    LengthRole
+};
+
+SearchWindow::SearchWindow(QWidget *parent) : QWidget(parent) {
+    setWindowTitle("Search in folder");
+    setAttribute(Qt::WA_DeleteOnClose);
+    resize(520, 420);
+
+    layout = new QVBoxLayout();
+    setLayout(layout);
+
+    QHBoxLayout *folderLayout = new QHBoxLayout();
+    folderEdit = new QLineEdit(this);
+    folderEdit->setReadOnly(true);
+    folderEdit->setPlaceholderText("Folder");
+    browseButton = new QPushButton("&Browse...", this);
+    connect(browseButton, &QPushButton::clicked, this, &SearchWindow::chooseFolder);
+    folderLayout->addWidget(folderEdit);
+    folderLayout->addWidget(browseButton);
+    layout->addLayout(folderLayout);
+
+    queryEdit = new QLineEdit(this);
+    queryEdit->setPlaceholderText("Words, or \"a phrase\" in quotes");
+    queryEdit->setEnabled(false);
+    connect(queryEdit, &QLineEdit::textChanged, this, [this]() {
+        searchTimer->start();
+    });
+    layout->addWidget(queryEdit);
+
+    results = new QListWidget(this);
+    connect(results, &QListWidget::itemActivated, this, &SearchWindow::openHit);
+    layout->addWidget(results);
+
+    status = new QLabel(this);
+    layout->addWidget(status);
+
+    progressTimer = new QTimer(this);
+    progressTimer->setInterval(200);
+    connect(progressTimer, &QTimer::timeout, this, &SearchWindow::showProgress);
+
+    // Search once typing pauses rather than on every keystroke.
+    searchTimer = new QTimer(this);
+    searchTimer->setSingleShot(true);
+    searchTimer->setInterval(150);
+    connect(searchTimer, &QTimer::timeout, this, &SearchWindow::search);
+}
+
+SearchWindow::~SearchWindow() {}
+
+void SearchWindow::chooseFolder() {
+    QString folder = QFileDialog::getExistingDirectory(this, "Search in folder", QDir::homePath());
+    if (!folder.isEmpty()) {
+        indexFolder(folder);
+    }
+}
+
+void SearchWindow::indexFolder(const QString &folder) {
+    folderEdit->setText(QDir::toNativeSeparators(folder));
+    browseButton->setEnabled(false);
+    queryEdit->setEnabled(false);
+    searchTimer->stop();
+    ++searchGeneration;
+    results->clear();
+
+    // The worker keeps its own references, closing the window does not
+    // interrupt indexing and the result is still saved for the next time.
+    // An index another window already holds is updated from a copy instead
+    // of being read from disk again.
+    std::shared_ptr<const FolderIndex> current = FolderIndex::shared(folder);
+    std::shared_ptr<FolderIndex> folderIndex = current ? std::make_shared<FolderIndex>(*current)
+                                                       : std::make_shared<FolderIndex>(folder);
+    progress = std::make_shared<Progress>();
+    std::shared_ptr<Progress> workerProgress = progress;
+
+    status->setText("Loading index...");
+    progressTimer->start();
+
+    QtConcurrent::run([folderIndex, workerProgress, loaded = bool(current)]() {
+        if (!loaded) {
+            folderIndex->load();
+        }
+        int changed = folderIndex->update([workerProgress](int done, int total) {
+            workerProgress->done = done;
+            workerProgress->total = total;
+        });
+        if (changed > 0) {
+            folderIndex->save();
+        }
+        FolderIndex::setShared(folderIndex);
+        return changed;
+    }).then(this, [this, folderIndex](int changed) {
+        progressTimer->stop();
+        index = folderIndex;
+        browseButton->setEnabled(true);
+        queryEdit->setEnabled(true);
+        status->setText(QString("%1 files indexed, %2 updated").arg(index->fileCount()).arg(changed));
+        search();
+    });
+}
+
+void SearchWindow::showProgress() {
+    if (progress && progress->total > 0) {
+        status->setText(QString("Indexing %1 of %2 files...").arg(progress->done.load()).arg(progress->total.load()));
+    }
+}
+
+void SearchWindow::search() {
+    searchTimer->stop();
+    int generation = ++searchGeneration;
+    if (!index || queryEdit->text().trimmed().isEmpty()) {
+        results->clear();
+        return;
+    }
+
+    // The index is not changed once it is shown, so it can be searched on
+    // the pool; results of a query typed over in the meantime are dropped.
+    std::shared_ptr<const FolderIndex> folderIndex = index;
+    QString query = queryEdit->text();
+    QtConcurrent::run([folderIndex, query]() {
+        QElapsedTimer timer;
+        timer.start();
+        QList<SearchHit> hits = folderIndex->search(query, 1000);
+        return qMakePair(hits, timer.elapsed());
+    }).then(this, [this, folderIndex, generation](const QPair<QList<SearchHit>, qint64> &result) {
+        if (generation != searchGeneration) {
+            return;
+        }
+
+        results->clear();
+        QDir folder(folderIndex->folder());
+        foreach (const SearchHit &hit, result.first) {
+            QListWidgetItem *item = new QListWidgetItem(
+                QString("%1 (%2)").arg(QDir::toNativeSeparators(folder.relativeFilePath(hit.path))).arg(hit.count), results);
+            item->setData(PathRole, hit.path);
+            item->setData(PositionRole, hit.position);
+            item->setData(LengthRole, hit.length);
+        }
+
+        status->setText(QString("%1 files found in %2 ms").arg(result.first.size()).arg(result.second));
+    });
+}
+
+void SearchWindow::openHit(QListWidgetItem *item) {
+    int position = item->data(PositionRole).toInt();
+    int length = item->data(LengthRole).toInt();
+
+    MainWindow *window = new MainWindow(item->data(PathRole).toString());
+    window->setAttribute(Qt::WA_DeleteOnClose);
+    connect(window, &MainWindow::fileLoaded, window, [window, position, length]() {
+        window->selectText(position, length);
+    });
+    window->show();
+}
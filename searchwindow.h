@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef SEARCHWINDOW_H
+#define SEARCHWINDOW_H
+
+#include "folderindex.h"
+
+#include <QWidget>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+
+class SearchWindow : public QWidget
+{
+    Q_OBJECT
+public:
+    SearchWindow(QWidget *parent = nullptr);
+    ~SearchWindow();
+private:
+    struct Progress
+    {
+        std::atomic<int> done { 0 };
+        std::atomic<int> total { 0 };
+    };
+
+    void chooseFolder();
+    void indexFolder(const QString &folder);
+    void showProgress();
+    void search();
+    void openHit(QListWidgetItem *item);
+
+    QVBoxLayout* layout;
+    QLineEdit* folderEdit;
+    QPushButton* browseButton;
+    QLineEdit* queryEdit;
+    QListWidget* results;
+    QLabel* status;
+    QTimer* progressTimer;
+    QTimer* searchTimer;
+    int searchGeneration = 0;
+
+    std::shared_ptr<const FolderIndex> index;
+    std::shared_ptr<Progress> progress;
+};
+
+#endif // SEARCHWINDOW_H
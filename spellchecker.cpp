@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "spellchecker.h"
+
+#include <QtConcurrent>
+#include <QAbstractTextDocumentLayout>
+#include <QScrollBar>
+
+static const qsizetype kBatchChars = 64 * 1024;
+static const int kSweepBlocks = 2000;
+static const int kTypingDelay = 300;
+static const int kEditedBlocks = 16;
+
+class SpellData : public QTextBlockUserData
+{
+public:
+    int revision;
+    int length;
+    QList<QPair<int, int>> errors;
+};
+
+SpellChecker::SpellChecker(QTextEdit *_textEdit, QObject *parent)
+    : QObject(parent), textEdit(_textEdit)
+{
+    batchTimer = new QTimer(this);
+    batchTimer->setSingleShot(true);
+    connect(batchTimer, &QTimer::timeout, this, &SpellChecker::runBatch);
+
+    selectionTimer = new QTimer(this);
+    selectionTimer->setSingleShot(true);
+    selectionTimer->setInterval(30);
+    connect(selectionTimer, &QTimer::timeout, this, &SpellChecker::updateSelections);
+
+    QTextDocument *document = textEdit->document();
+    connect(document, &QTextDocument::contentsChange, this, &SpellChecker::contentsChange);
+    connect(document->documentLayout(), &QAbstractTextDocumentLayout::documentSizeChanged, this, [this]() {
+        selectionTimer->start();
+    });
+    connect(textEdit->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+        selectionTimer->start();
+        if (!batchTimer->isActive()) {
+            schedule(0);
+        }
+    });
+
+    // Mapping and hashing a large word list takes a moment, do it off the GUI thread.
+    QtConcurrent::run(&SpellDictionary::shared).then(this, [this](std::shared_ptr<const SpellDictionary> loaded) {
+        if (!loaded->isEmpty()) {
+            dictionary = loaded;
+            schedule(0);
+        }
+    });
+}
+
+SpellChecker::~SpellChecker() {}
+
+void SpellChecker::setEnabled(bool _enabled) {
+    enabled = _enabled;
+    if (enabled) {
+        schedule(0);
+    } else {
+        batchTimer->stop();
+    }
+    updateSelections();
+}
+
+void SpellChecker::contentsChange(int position, int removed, int added) {
+    Q_UNUSED(removed);
+
+    QTextDocument *document = textEdit->document();
+    QTextBlock first = document->findBlock(position);
+    QTextBlock last = document->findBlock(position + added);
+    if (!first.isValid()) {
+        return;
+    }
+    if (!last.isValid()) {
+        last = document->lastBlock();
+    }
+
+    // Typing touches a block or two, anything bigger (loading, pasting a
+    // long text) is left to the sweep.
+    if (last.blockNumber() - first.blockNumber() < kEditedBlocks) {
+        for (QTextBlock block = first; block.isValid() && block.position() <= last.position(); block = block.next()) {
+            edited.append(block.position());
+        }
+    } else {
+        sweepBlock = qMin(sweepBlock, first.blockNumber());
+    }
+
+    schedule(kTypingDelay);
+}
+
+void SpellChecker::schedule(int delay) {
+    if (enabled && dictionary) {
+        batchTimer->start(delay);
+    }
+}
+
+bool SpellChecker::isStale(const QTextBlock &block) const {
+    SpellData *data = static_cast<SpellData *>(block.userData());
+    return !data || data->revision != block.revision() || data->length != block.length();
+}
+
+void SpellChecker::visibleBlocks(QTextBlock *first, QTextBlock *last) const {
+    QRect area = textEdit->viewport()->rect();
+    *first = textEdit->cursorForPosition(area.topLeft()).block();
+    *last = textEdit->cursorForPosition(area.bottomRight()).block();
+}
+
+void SpellChecker::runBatch() {
+    if (running || !enabled || !dictionary) {
+        return;
+    }
+
+    QList<Task> tasks;
+    qsizetype budget = kBatchChars;
+    auto take = [&](const QTextBlock &block, bool force) {
+        if (block.isValid() && (force || isStale(block))) {
+            tasks.append({ block.position(), block.revision(), block.text(), {} });
+            budget -= block.length();
+        }
+    };
+
+    QTextBlock first, last;
+    visibleBlocks(&first, &last);
+    for (QTextBlock block = first; block.isValid() && block.position() <= last.position() && budget > 0; block = block.next()) {
+        take(block, false);
+    }
+
+    QTextDocument *document = textEdit->document();
+    while (!edited.isEmpty() && budget > 0) {
+        take(document->findBlock(edited.takeFirst()), true);
+    }
+
+    QTextBlock block = document->findBlockByNumber(sweepBlock);
+    for (int scanned = 0; block.isValid() && budget > 0 && scanned < kSweepBlocks; ++scanned) {
+        take(block, false);
+        block = block.next();
+    }
+    sweepBlock = block.isValid() ? block.blockNumber() : document->blockCount();
+    bool more = block.isValid() || !edited.isEmpty();
+
+    if (tasks.isEmpty()) {
+        if (more) {
+            schedule(0);
+        }
+        return;
+    }
+
+    running = true;
+    std::shared_ptr<const SpellDictionary> words = dictionary;
+    QtConcurrent::run([words, tasks]() mutable {
+        for (Task &task : tasks) {
+            task.errors = misspelled(*words, task.text);
+        }
+        return tasks;
+    }).then(this, [this](const QList<Task> &checked) {
+        finished(checked);
+    });
+}
+
+void SpellChecker::finished(const QList<Task> &tasks) {
+    running = false;
+
+    QTextDocument *document = textEdit->document();
+    for (const Task &task : tasks) {
+        // Edited or moved while being checked, it is stale and will be picked up again.
+        QTextBlock block = document->findBlock(task.position);
+        if (!block.isValid() || block.position() != task.position
+            || block.revision() != task.revision || block.text() != task.text) {
+            continue;
+        }
+        SpellData *data = new SpellData();
+        data->revision = task.revision;
+        data->length = block.length();
+        data->errors = task.errors;
+        block.setUserData(data);
+    }
+
+    updateSelections();
+    schedule(0);
+}
+
+void SpellChecker::updateSelections() {
+    QList<QTextEdit::ExtraSelection> selections;
+
+    if (enabled && dictionary) {
+        QTextCharFormat format;
+        format.setUnderlineStyle(QTextCharFormat::SpellCheckUnderline);
+        format.setUnderlineColor(Qt::red);
+
+        QTextBlock first, last;
+        visibleBlocks(&first, &last);
+        for (QTextBlock block = first; block.isValid() && block.position() <= last.position(); block = block.next()) {
+            SpellData *data = static_cast<SpellData *>(block.userData());
+            if (!data || data->length != block.length()) {
+                continue;
+            }
+            for (const QPair<int, int> &error : std::as_const(data->errors)) {
+                QTextEdit::ExtraSelection selection;
+                selection.cursor = QTextCursor(block);
+                selection.cursor.setPosition(block.position() + error.first);
+                selection.cursor.setPosition(block.position() + error.first + error.second, QTextCursor::KeepAnchor);
+                selection.format = format;
+                selections.append(selection);
+            }
+        }
+    }
+
+    textEdit->setExtraSelections(selections);
+}
+
+QList<QPair<int, int>> SpellChecker::misspelled(const SpellDictionary &dictionary, const QString &text) {
+    QList<QPair<int, int>> errors;
+    const qsizetype size = text.size();
+    qsizetype pos = 0;
+
+    while (pos < size) {
+        while (pos < size && !text.at(pos).isLetter()) {
+            ++pos;
+        }
+
+        qsizetype start = pos;
+        bool digits = false;
+        while (pos < size) {
+            QChar c = text.at(pos);
+            // Apostrophes inside a word ("don't") belong to it.
+            bool apostrophe = (c == u'\'' || c == u'\u2019') && pos > start
+                              && pos + 1 < size && text.at(pos + 1).isLetter();
+            if (!c.isLetterOrNumber() && !apostrophe) {
+                break;
+            }
+            digits |= c.isDigit();
+            ++pos;
+        }
+
+        qsizetype length = pos - start;
+        if (length > 1 && !digits && !dictionary.contains(text.mid(start, length))) {
+            errors.append(qMakePair(int(start), int(length)));
+        }
+    }
+
+    return errors;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef SPELLCHECKER_H
+#define SPELLCHECKER_H
+
+#include "spelldictionary.h"
+
+#include <QObject>
+#include <QTextEdit>
+#include <QTextBlock>
+#include <QTimer>
+
+// Background spell checking for a QTextEdit. Results are stored per block
+// and reused while the block is unchanged; edited and visible blocks are
+// checked first, the rest of the document in small slices afterwards.
+// Errors are shown with extra selections, the document itself is not touched.
+class SpellChecker : public QObject
+{
+    Q_OBJECT
+public:
+    SpellChecker(QTextEdit *textEdit, QObject *parent);
+    ~SpellChecker();
+
+    bool isEnabled() const { return enabled; }
+    void setEnabled(bool enabled);
+
+private:
+    // Blocks are remembered by position and looked up again when needed,
+    // a QTextBlock handle does not survive the document being rebuilt.
+    struct Task
+    {
+        int position;
+        int revision;
+        QString text;
+        QList<QPair<int, int>> errors;
+    };
+
+    void contentsChange(int position, int removed, int added);
+    void schedule(int delay);
+    void runBatch();
+    void finished(const QList<Task> &tasks);
+    void updateSelections();
+
+    bool isStale(const QTextBlock &block) const;
+    void visibleBlocks(QTextBlock *first, QTextBlock *last) const;
+
+    static QList<QPair<int, int>> misspelled(const SpellDictionary &dictionary, const QString &text);
+
+    QTextEdit* textEdit;
+    std::shared_ptr<const SpellDictionary> dictionary;
+    QTimer* batchTimer;
+    QTimer* selectionTimer;
+    QList<int> edited;
+    int sweepBlock = 0;
+    bool running = false;
+    bool enabled = true;
+};
+
+#endif // SPELLCHECKER_H
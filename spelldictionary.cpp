@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "spelldictionary.h"
+
+#include <QStandardPaths>
+
+bool SpellDictionary::load(const QString &path) {
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const char *data = file.size() > 0 ? reinterpret_cast<const char *>(file.map(0, file.size())) : nullptr;
+    if (!data) {
+        file.close();
+        return false;
+    }
+
+    const char *end = data + file.size();
+    words.reserve(size_t(file.size() / 8));
+    while (data < end) {
+        const char *line = data;
+        while (data < end && *data != '\n') {
+            ++data;
+        }
+        const char *lineEnd = data;
+        if (lineEnd > line && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        if (lineEnd > line) {
+            words.emplace(line, size_t(lineEnd - line));
+        }
+        ++data;
+    }
+    return true;
+}
+
+bool SpellDictionary::contains(const QString &word) const {
+    // Word lists spell "don't" with an ASCII apostrophe, typeset text with U+2019.
+    if (word.contains(u'\u2019')) {
+        return contains(QString(word).replace(u'\u2019', u'\''));
+    }
+
+    QByteArray utf8 = word.toUtf8();
+    if (words.count(std::string_view(utf8.constData(), size_t(utf8.size())))) {
+        return true;
+    }
+
+    // Capitalised words at the start of a sentence.
+    utf8 = word.toLower().toUtf8();
+    return words.count(std::string_view(utf8.constData(), size_t(utf8.size()))) > 0;
+}
+
+std::shared_ptr<const SpellDictionary> SpellDictionary::shared() {
+    static std::shared_ptr<const SpellDictionary> dictionary = []() {
+        QStringList candidates = {
+            qEnvironmentVariable("TEXEDIT_DICTIONARY"),
+            QStandardPaths::locate(QStandardPaths::AppDataLocation, "words.txt"),
+            "/usr/share/dict/words"
+        };
+
+        auto loaded = std::make_shared<SpellDictionary>();
+        foreach (const QString &path, candidates) {
+            if (!path.isEmpty() && loaded->load(path)) {
+                break;
+            }
+        }
+        return std::shared_ptr<const SpellDictionary>(loaded);
+    }();
+    return dictionary;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef SPELLDICTIONARY_H
+#define SPELLDICTIONARY_H
+
+#include <QFile>
+#include <QString>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+
+// Word list with one word per line, memory-mapped. Lookups use views into
+// the mapping, so the words are never copied. Immutable once loaded and
+// safe to share between threads.
+class SpellDictionary
+{
+public:
+    bool load(const QString &path);
+    bool isEmpty() const { return words.empty(); }
+    bool contains(const QString &word) const;
+
+    // The dictionary shared by all windows, loaded on first use from
+    // $TEXEDIT_DICTIONARY, words.txt in the application data folder or the
+    // system word list. Empty when none of them exists.
+    static std::shared_ptr<const SpellDictionary> shared();
+
+private:
+    QFile file;
+    std::unordered_set<std::string_view> words;
+};
+
+#endif // SPELLDICTIONARY_H
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef TEXTEDITOR_H
+#define TEXTEDITOR_H
+
+#include <QTextEdit>
+#include <QVariant>
+#include <QUrl>
+#include <functional>
+
+// QTextEdit whose document resources can be supplied from outside. The
+// document asks the editor before anything else, so a loader set here sees
+// every resource the document does not have yet.
+class TextEditor : public QTextEdit
+{
+    Q_OBJECT
+public:
+    using ResourceLoader = std::function<QVariant(int type, const QUrl &name)>;
+
+    TextEditor(QWidget *parent = nullptr);
+
+    void setResourceLoader(const ResourceLoader &loader);
+
+protected:
+    QVariant loadResource(int type, const QUrl &name) override;
+
+private:
+    ResourceLoader resourceLoader;
+};
+
+#endif // TEXTEDITOR_H